@@ -1,9 +1,15 @@
 #include "qtmvt.hpp"
 
 #include <QTableView>
+#include <QTreeView>
 #include <QPushButton>
+#include <QCheckBox>
+#include <QLineEdit>
+#include <QItemSelectionModel>
 #include <QVBoxLayout>
 #include <QApplication>
+#include <QElapsedTimer>
+#include <QTimer>
 
 #include "ui_examplesuite.h"
 
@@ -55,7 +61,12 @@ int main(int argc, char **argv)
 
     Model::List<Person, QString> editablePersonList {
         {"Person", "Profession"},
-        {make_tuple(Person{"Romário", 24}, "Programador")},
+        {
+            make_tuple(Person{"Romário", 24}, "Programador"),
+            make_tuple(Person{"Maria", 19}, "Estudante"),
+            make_tuple(Person{"Isabela", 33}, "Médica"),
+            make_tuple(Person{"Antônio", 40}, "Pedreiro")
+        },
         {
             {
                 {Qt::DisplayRole, [](const Person &p) { return p.name; }},
@@ -128,6 +139,12 @@ int main(int argc, char **argv)
     ui.noDefCtor->setModel(&noDefaultPersonList);
     ui.proto->setModel(&fromPrototype);
 
+    // Maria can't be renamed, Isabela can't be selected and Antônio is
+    // disabled altogether, whatever their columns allow
+    editablePersonList.setRowReadOnly(1);
+    editablePersonList.setRowSelectable(2, false);
+    editablePersonList.setRowEnabled(3, false);
+
     QObject::connect(ui.insertableInsert, &QPushButton::clicked, [&ui, &insertablePersonList]()
     {
         int row = insertablePersonList.rowCount();
@@ -145,6 +162,17 @@ int main(int argc, char **argv)
         removablePersonList.removeRow(0);
     });
 
+    // Selects the people whose name or age contains the text typed so far
+    removablePersonList.setSearchColumns({0});
+    QObject::connect(ui.removableSearch, &QLineEdit::textChanged, [&ui, &removablePersonList](const QString &text)
+    {
+        auto selection = ui.removable->selectionModel();
+        selection->clearSelection();
+
+        for (auto &&index : removablePersonList.search(text))
+            selection->select(index, QItemSelectionModel::Select);
+    });
+
     QObject::connect(ui.noDefCtorInsert, &QPushButton::clicked, [&ui, &noDefaultPersonList]()
     {
         noDefaultPersonList.append(
@@ -175,6 +203,132 @@ int main(int argc, char **argv)
                     ui.protoAge->value()}));
     });
 
+    // The list keeps a pointer to the title of the computed column, so it
+    // must stay alive until the column is retitled or removed
+    auto bracketTitle = ui.nonEditableBracketTitle->text().toUtf8();
+
+    QObject::connect(ui.nonEditableBracket, &QCheckBox::toggled, [&personList, &bracketTitle](bool checked)
+    {
+        if (!checked) {
+            personList.removeComputedColumn(2);
+            return;
+        }
+
+        personList.addComputedColumn<0>(
+            bracketTitle.constData(),
+            [](const tuple<Person, QString> &row)
+            {
+                const int decade = get<0>(row).age / 10 * 10;
+                return QString{"%1 to %2"}.arg(decade).arg(decade + 9);
+            });
+    });
+
+    QObject::connect(ui.nonEditableBracketTitle, &QLineEdit::editingFinished, [&ui, &personList, &bracketTitle]()
+    {
+        bracketTitle = ui.nonEditableBracketTitle->text().toUtf8();
+        personList.setHeaderTitle(2, bracketTitle.constData());
+    });
+
+    // Groups the staff by team; the count and the total, minimum and
+    // maximum ages of each team follow the edits made to the staff list
+    Model::List<QString, QString, int> staff {
+        {"Name", "Team", "Age"},
+        {
+            make_tuple("Romário", "Development", 24),
+            make_tuple("Maria", "Development", 19),
+            make_tuple("Isabela", "Support", 33),
+            make_tuple("Antônio", "Sales", 40),
+            make_tuple("Alícia", "Support", 50),
+            make_tuple("João", "Development", 26)
+        },
+
+        [](const QString &s) { return s; },
+        [](const QString &s) { return s; },
+        [](const int &i) { return i; },
+
+        [](QString &s, const QVariant &v) { s = v.toString(); return true; },
+        [](QString &s, const QVariant &v) { s = v.toString(); return true; },
+        [](int &i, const QVariant &v) { i = v.toInt(); return true; }
+    };
+
+    Model::GroupedView<1, QString, QString, int> staffByTeam{staff, "Team"};
+    staffByTeam.addSum<2>("Total age");
+    staffByTeam.addMinimum<2>("Youngest");
+    staffByTeam.addMaximum<2>("Oldest");
+
+    ui.groupSource->setModel(&staff);
+    ui.grouped->setModel(&staffByTeam);
+
+    // Reordering the staff moves rows around without changing any group
+    QObject::connect(ui.groupSourceReverse, &QPushButton::clicked, [&staff]()
+    {
+        vector<int> newOrder(staff.rowCount());
+        for (size_t i = 0; i < newOrder.size(); ++i)
+            newOrder[i] = newOrder.size() - 1 - i;
+
+        staff.permute(newOrder);
+    });
+
+    QObject::connect(ui.groupSourceMove, &QPushButton::clicked, [&staff]()
+    {
+        staff.moveRows({}, 0, 1, {}, staff.rowCount());
+    });
+
+    // While the button is down, feeds about 50 thousand events per second
+    // into a list bounded to 100 thousand rows, showing how many were fed
+    // and how many flush() appends per second of its own running time
+    Model::List<int, QString> boundedLog{{"Event", "Message"}};
+    boundedLog.setMaximumRowCount(100000);
+    ui.boundedLog->setModel(&boundedLog);
+
+    int loggedEvents = 0;
+    int loggedEventsBefore = 0;
+    qint64 flushNsecs = 0;
+    QElapsedTimer logClock;
+    QTimer logTimer;
+    logTimer.setTimerType(Qt::PreciseTimer);
+
+    QObject::connect(&logTimer, &QTimer::timeout, [&]()
+    {
+        for (int i = 0; i < 50; ++i, ++loggedEvents)
+            boundedLog.enqueue(make_tuple(loggedEvents, QString{"Event number %1"}.arg(loggedEvents)));
+
+        // Flushing right away instead of waiting for the queued flush keeps
+        // the rest of the event loop out of the measurement
+        QElapsedTimer flushClock;
+        flushClock.start();
+        boundedLog.flush();
+        flushNsecs += flushClock.nsecsElapsed();
+
+        const auto elapsed = logClock.elapsed();
+        if (elapsed < 1000)
+            return;
+
+        const qint64 events = loggedEvents - loggedEventsBefore;
+        ui.boundedLogRate->setText(
+            QString{"%1 events/s fed, %2 events/s through flush(), %3 rows"}
+                .arg(events * 1000 / elapsed)
+                .arg(events * 1000000000 / qMax(flushNsecs, qint64{1}))
+                .arg(boundedLog.rowCount()));
+
+        loggedEventsBefore = loggedEvents;
+        flushNsecs = 0;
+        logClock.restart();
+    });
+
+    QObject::connect(ui.boundedLogFeed, &QPushButton::toggled, [&](bool feeding)
+    {
+        if (!feeding) {
+            logTimer.stop();
+            return;
+        }
+
+        loggedEventsBefore = loggedEvents;
+        flushNsecs = 0;
+        logClock.start();
+        logTimer.start(1);
+    });
+
     w.show();
 
     Model::Table<int> simpleTable{
@@ -185,5 +339,27 @@ int main(int argc, char **argv)
         }}};
     ui.simpleTable->setModel(&simpleTable);
 
+    typedef Model::Tree<QString, int> DirectoryTree;
+    DirectoryTree lazyTree{
+        {"Directory", "Depth"},
+        {
+            {make_tuple(QString{"usr"}, 0), {}},
+            {make_tuple(QString{"home"}, 0), {}}
+        },
+
+        [](const QString &s) { return s; },
+        [](const int &depth) { return depth; }
+    };
+
+    lazyTree.setFetchFunction([](const tuple<QString, int> &dir)
+    {
+        vector<DirectoryTree::Node> children;
+        for (auto &&name : {"bin", "lib", "share"})
+            children.push_back({make_tuple(get<0>(dir) + "/" + name, get<1>(dir) + 1), {}});
+
+        return children;
+    });
+    ui.lazyTree->setModel(&lazyTree);
+
     return a.exec();
 }
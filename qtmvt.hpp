@@ -29,16 +29,26 @@
 #define LISTMODEL_HPP
 
 // Qt includes
+#include <QAbstractItemModel>
 #include <QAbstractTableModel>
 #include <QHash>
+#include <QStringMatcher>
+#include <QTimer>
 
 // STL includes
+#include <algorithm>
 #include <array>
+#include <bitset>
+#include <deque>
 #include <initializer_list>
 #include <functional>
+#include <map>
+#include <memory>
+#include <set>
 #include <utility>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 using std::make_tuple;
 
@@ -64,6 +74,25 @@ namespace QtMVT
         static const bool value = std::is_default_constructible<T>::value;
     };
 
+    template <std::size_t Size, std::size_t... Columns>
+    class ColumnsAreInRange;
+
+    template <std::size_t Size, std::size_t Column, std::size_t... Columns>
+    class ColumnsAreInRange<Size, Column, Columns...>
+    {
+    public:
+        static const bool value =
+            Column < Size &&
+            ColumnsAreInRange<Size, Columns...>::value;
+    };
+
+    template <std::size_t Size>
+    class ColumnsAreInRange<Size>
+    {
+    public:
+        static const bool value = true;
+    };
+
     }
 
     namespace Model
@@ -75,6 +104,9 @@ namespace QtMVT
     template <bool B, typename... Types>
     class ListInsertRows;
 
+    template <int I, typename... Types>
+    class TreeDataAccess;
+
         namespace Util
         {
 
@@ -145,7 +177,9 @@ namespace QtMVT
             _headerTitles(std::move(headerTitles)),
             _rows{l},
             _roleFunctions{roles...}
-        {}
+        {
+            _updateColumnFlags();
+        }
 
         List(
             std::array<const char *, rowSize> &&headerTitles,
@@ -200,7 +234,15 @@ namespace QtMVT
             QAbstractTableModel{parent},
             _headerTitles(other._headerTitles),
             _rows{other._rows},
-            _roleFunctions{other._roleFunctions}
+            _roleFunctions{other._roleFunctions},
+            _computedColumns(other._computedColumns),
+            _computedValues(other._computedValues),
+            _computedIsCached(other._computedIsCached),
+            _maximumRowCount{other._maximumRowCount},
+            _searchColumns(other._searchColumns),
+            _searchTexts(other._searchTexts),
+            _columnFlags(other._columnFlags),
+            _disabledRowFlags(other._disabledRowFlags)
         {}
 
         List(List<Types...> &&) = default;
@@ -209,7 +251,13 @@ namespace QtMVT
             std::initializer_list<_RowType> &&l = {},
             QObject *parent = nullptr)
         {
-            return {_headerTitles, std::move(l), _roleFunctions, parent};
+            return {
+                _headerTitles,
+                std::move(l),
+                _roleFunctions,
+                _computedColumns,
+                _maximumRowCount,
+                parent};
         }
 
         List<Types...> createNew(QObject *parent)
@@ -224,7 +272,7 @@ namespace QtMVT
 
         int columnCount(const QModelIndex & = {}) const
         {
-            return std::tuple_size<_RowType>::value;
+            return rowSize + _computedColumns.size();
         }
 
         QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const
@@ -232,6 +280,9 @@ namespace QtMVT
             if (_indexIsInvalid(index))
                 return {};
 
+            if (index.column() >= rowSize)
+                return _computedData(index.row(), index.column() - rowSize, role);
+
             return ListDataAccess<rowSize - 1, Types...>::getFromIndex(*this, index, role);
         }
 
@@ -239,29 +290,54 @@ namespace QtMVT
         {
             if (
                 section < 0 ||
-                section >= rowSize ||
+                section >= columnCount() ||
                 orientation != Qt::Horizontal ||
                 role != Qt::DisplayRole)
                 return QAbstractTableModel::headerData(section, orientation, role);
 
+            if (section >= rowSize)
+                return _computedColumns[section - rowSize].title;
+
             return _headerTitles[section];
         }
 
         Qt::ItemFlags flags(const QModelIndex &index) const
         {
-            return
-                QAbstractTableModel::flags(index) |
-                (ListDataAccess<rowSize - 1, Types...>::columnIsEditable(*this, index.column())?
-                     Qt::ItemIsEditable :
-                     Qt::NoItemFlags);
+            if (_indexIsInvalid(index))
+                return QAbstractTableModel::flags(index);
+
+            auto flags = _columnFlags[index.column()];
+            if (_disabledRowFlags.empty())
+                return flags;
+
+            if (_rowFlagIsDisabled(index.row(), _RowNotSelectable))
+                flags.setFlag(Qt::ItemIsSelectable, false);
+            if (_rowFlagIsDisabled(index.row(), _RowReadOnly))
+                flags.setFlag(Qt::ItemIsEditable, false);
+            if (_rowFlagIsDisabled(index.row(), _RowDisabled))
+                flags.setFlag(Qt::ItemIsEnabled, false);
+
+            return flags;
         }
 
         bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole)
         {
-            if (_indexIsInvalid(index))
-                return {};
+            if (_indexIsInvalid(index) || _rowFlagIsDisabled(index.row(), _RowReadOnly))
+                return false;
+
+            if (!ListDataAccess<rowSize - 1, Types...>::setInIndex(*this, index, value, role))
+                return false;
+
+            const auto computed = _invalidateComputedValues(index.row(), index.column());
+            _updateSearchTexts(index.row());
 
-            return ListDataAccess<rowSize - 1, Types...>::setInIndex(*this, index, value, role);
+            emit dataChanged(index, index);
+            if (computed.first >= 0)
+                emit dataChanged(
+                    this->index(index.row(), rowSize + computed.first),
+                    this->index(index.row(), rowSize + computed.second));
+
+            return true;
         }
 
         bool insertRows(int row, int count, const QModelIndex &parent = {})
@@ -283,14 +359,82 @@ namespace QtMVT
             beginRemoveRows(parent, row, row + count - 1);
 
             auto rowIt = _rows.begin() + row;
-            for (int i = 0; i < count; ++i)
-                _rows.erase(rowIt);
+            _rows.erase(rowIt, rowIt + count);
+
+            _removeRowData(row, count);
 
             endRemoveRows();
 
             return true;
         }
 
+        bool moveRows(
+            const QModelIndex &sourceParent,
+            int sourceRow,
+            int count,
+            const QModelIndex &destinationParent,
+            int destinationChild)
+        {
+            if (count == 0)
+                return true;
+
+            if (sourceParent.isValid() ||
+                destinationParent.isValid() ||
+                sourceRow < 0 ||
+                count < 0 ||
+                static_cast<size_t>(sourceRow + count) > _rows.size() ||
+                destinationChild < 0 ||
+                static_cast<size_t>(destinationChild) > _rows.size())
+                return false;
+
+            if (!beginMoveRows(
+                    sourceParent, sourceRow, sourceRow + count - 1,
+                    destinationParent, destinationChild))
+                return false;
+
+            _moveRange(_rows, sourceRow, count, destinationChild);
+            _moveRowData(sourceRow, count, destinationChild);
+
+            endMoveRows();
+
+            return true;
+        }
+
+        // Reorders all rows in place so that row i becomes the row that was
+        // at newOrder[i], emitting a single layout change
+        bool permute(const std::vector<int> &newOrder)
+        {
+            if (newOrder.size() != _rows.size())
+                return false;
+
+            std::vector<int> newRows(newOrder.size(), -1);
+            for (size_t i = 0; i < newOrder.size(); ++i) {
+                const auto oldRow = newOrder[i];
+                if (oldRow < 0 ||
+                    static_cast<size_t>(oldRow) >= newOrder.size() ||
+                    newRows[oldRow] >= 0)
+                    return false;
+
+                newRows[oldRow] = i;
+            }
+
+            emit layoutAboutToBeChanged();
+
+            const auto oldIndexes = persistentIndexList();
+            QModelIndexList newIndexes;
+            for (auto &&oldIndex : oldIndexes)
+                newIndexes.append(index(newRows[oldIndex.row()], oldIndex.column()));
+
+            _permute(_rows, newOrder);
+            _permuteRowData(newOrder);
+
+            changePersistentIndexList(oldIndexes, newIndexes);
+
+            emit layoutChanged();
+
+            return true;
+        }
+
         const std::tuple<Types...> &row(int rowIndex) const
         {
             Q_ASSERT(rowIndex >= 0 && rowIndex < _rows.size());
@@ -307,12 +451,7 @@ namespace QtMVT
                 static_cast<size_t>(row) > _rows.size())
                 return false;
 
-            beginInsertRows({}, row, row + rows.size() - 1);
-
-            auto rowIt = _rows.begin() + row;
-            _rows.insert(rowIt, rows);
-
-            endInsertRows();
+            _insertRows(row, rows.begin(), rows.end());
 
             return true;
         }
@@ -332,6 +471,47 @@ namespace QtMVT
             return append({std::move(rowElements)});
         }
 
+        // Queues a row to be appended on the next event loop iteration, so
+        // rows arriving at a high rate cause one insertion (and at most one
+        // eviction) per iteration instead of one per row
+        void enqueue(_RowType &&rowElements)
+        {
+            _pendingRows.push_back(std::move(rowElements));
+
+            if (_pendingRows.size() == 1)
+                QTimer::singleShot(0, this, [this]() { flush(); });
+        }
+
+        // Appends the rows queued by enqueue() right away
+        void flush()
+        {
+            if (_pendingRows.empty())
+                return;
+
+            std::vector<_RowType> rows;
+            rows.swap(_pendingRows);
+
+            _insertRows(
+                _rows.size(),
+                std::make_move_iterator(rows.begin()),
+                std::make_move_iterator(rows.end()));
+        }
+
+        // Bounds the list to at most count rows, evicting the oldest (first)
+        // rows whenever an insertion goes over the limit; 0 means unbounded
+        void setMaximumRowCount(int count)
+        {
+            Q_ASSERT(count >= 0);
+
+            _maximumRowCount = count;
+            _evictExcessRows();
+        }
+
+        int maximumRowCount() const
+        {
+            return _maximumRowCount;
+        }
+
         template <std::size_t Column>
         void addRoleFunction(
             int role,
@@ -345,6 +525,7 @@ namespace QtMVT
 
             auto &functions = std::get<Column>(_roleFunctions).roles;
             functions.insert(role, function);
+            _resetSearchTexts();
 
             endResetModel();
         }
@@ -374,6 +555,7 @@ namespace QtMVT
 
             auto &functions = std::get<Column>(_roleFunctions).editRoles;
             functions.insert(editRole, function);
+            _updateColumnFlags();
 
             endResetModel();
         }
@@ -397,6 +579,7 @@ namespace QtMVT
 
             auto &functions = std::get<Column>(_roleFunctions).roles;
             functions.remove(role);
+            _resetSearchTexts();
 
             endResetModel();
         }
@@ -408,203 +591,1617 @@ namespace QtMVT
 
             auto &functions = std::get<Column>(_roleFunctions).editRoles;
             functions.remove(role);
+            _updateColumnFlags();
 
             endResetModel();
         }
 
         void setHeaderTitle(int section, const char *title)
         {
-            _headerTitles[section] = title;
+            if (section < 0 || section >= columnCount())
+                return;
+
+            if (section >= rowSize)
+                _computedColumns[section - rowSize].title = title;
+            else
+                _headerTitles[section] = title;
+
+            emit headerDataChanged(Qt::Horizontal, section, section);
         }
 
-    private:
-        inline bool _indexIsInvalid(const QModelIndex &index) const
+        // Adds a read-only column computed from the whole row. Values are
+        // computed on first access and cached until one of the Dependencies
+        // columns is edited; no dependencies means any column.
+        template <std::size_t... Dependencies>
+        int addComputedColumn(
+            const char *title,
+            std::function<QVariant(const std::tuple<Types...> &)> &&function)
         {
-            return
-                !index.isValid() ||
-                index.row() < 0 ||
-                index.row() >= rowCount() ||
-                index.column() < 0 ||
-                index .column() >= columnCount();
-        }
+            static_assert(
+                QtMVT::Util::ColumnsAreInRange<rowSize, Dependencies...>::value,
+                "Computed column depends on a column that doesn't exist");
 
-        std::array<const char *, rowSize> _headerTitles;
-        std::vector<_RowType> _rows;
-        std::tuple<Util::RoleFunctions<Types>...> _roleFunctions;
+            _ComputedColumn computed{title, function, {}};
+            if (sizeof...(Dependencies) == 0)
+                computed.dependencies.set();
 
-        List(
-            const decltype(_headerTitles) &headerTitles,
-            std::initializer_list<_RowType> &&l,
-            const decltype(_roleFunctions) &roleFunctions,
-            QObject *parent)
-        :
-            QAbstractTableModel{parent},
-            _headerTitles(std::move(headerTitles)),
-            _rows{l},
-            _roleFunctions{roleFunctions}
-        {}
+            for (auto &&column : std::initializer_list<std::size_t>{Dependencies...})
+                computed.dependencies.set(column);
 
-        template <int I, typename... ListTypes>
-        friend class ListDataAccess;
+            const int column = columnCount();
+            beginInsertColumns({}, column, column);
 
-        template <bool B, typename... ListTypes>
-        friend class ListInsertRows;
-    };
+            _computedColumns.push_back(std::move(computed));
+            _resetComputedValues();
+            _resetSearchTexts();
+            _updateColumnFlags();
 
-    template <int I, typename... Types>
-    class ListDataAccess
-    {
-    public:
-        static QVariant getFromIndex(const List<Types...> &list, const QModelIndex &i, int role)
-        {
-            if (i.column() != I)
-                return ListDataAccess<I - 1, Types...>::getFromIndex(list, i, role);
+            endInsertColumns();
 
-            return std::get<I>(list._roleFunctions).data(
-                role,
-                std::get<I>(list._rows[i.row()]));
+            return column;
         }
 
-        static bool columnIsEditable(const List<Types...> &list, const int &column)
+        bool removeComputedColumn(int column)
         {
-            if (column != I)
-                return ListDataAccess<I - 1, Types...>::columnIsEditable(list, column);
+            if (column < rowSize || column >= columnCount())
+                return false;
 
-            return std::get<I>(list._roleFunctions).isEditable();
-        }
+            beginRemoveColumns({}, column, column);
 
-        static bool setInIndex(List<Types...> &list, const QModelIndex &i, const QVariant &data, const int &role)
-        {
-            if (i.column() != I)
-                return ListDataAccess<I - 1, Types...>::setInIndex(list, i, data, role);
+            _computedColumns.erase(_computedColumns.begin() + (column - rowSize));
+            _resetComputedValues();
+            _resetSearchTexts();
+            _updateColumnFlags();
 
-            return std::get<I>(list._roleFunctions).setData(
-                role,
-                std::get<I>(list._rows[i.row()]),
-                data);
+            endRemoveColumns();
+
+            return true;
         }
-    };
 
-    template <typename... Types>
-    class ListDataAccess<-1, Types...>
-    {
-    public:
-        static QVariant getFromIndex(const List<Types...> &, const QModelIndex &, int)
+        // Per-row overrides, applied on top of the flags of each column
+        void setRowReadOnly(int row, bool readOnly = true)
         {
-            return {};
+            _setRowFlagDisabled(row, _RowReadOnly, readOnly);
         }
 
-        static bool columnIsEditable(const List<Types...> &, const int &)
+        void setRowSelectable(int row, bool selectable = true)
         {
-            return false;
+            _setRowFlagDisabled(row, _RowNotSelectable, !selectable);
         }
 
-        static bool setInIndex(List<Types...> &, const QModelIndex &, const QVariant &, const int &)
+        void setRowEnabled(int row, bool enabled = true)
         {
-            return false;
+            _setRowFlagDisabled(row, _RowDisabled, !enabled);
         }
-    };
 
-    template <bool DefaultConstructible, typename... Types>
-    class ListInsertRows;
+        // Makes search() look into the given columns. Their display text is
+        // case folded and kept up to date as rows are inserted, removed,
+        // moved or edited; no columns disables searching.
+        void setSearchColumns(std::initializer_list<int> &&columns)
+        {
+            _searchColumns.assign(columns.begin(), columns.end());
+            _resetSearchTexts();
+        }
 
-    template <typename... Types>
-    class ListInsertRows<true, Types...>
-    {
-    public:
-        static bool func(List<Types...> &l, int row, int count, const QModelIndex &parent)
+        // Returns the indexes of the search columns containing text,
+        // ignoring case. When text extends the previous query, only the
+        // previous matches are checked again; they are kept up to date as
+        // rows change.
+        QModelIndexList search(const QString &text) const
         {
-            if (count == 0)
-                return true;
+            QModelIndexList result;
+
+            const auto query = text.toCaseFolded();
+            if (query.isEmpty() || _searchColumns.empty())
+                return result;
+
+            // One matcher serves every row, instead of QString::indexOf
+            // preparing its search over again for each call
+            const QStringMatcher matcher{query};
+
+            std::vector<int> matches;
+            const auto lastQuery = _lastMatcher.pattern();
+            if (!lastQuery.isEmpty() && query.contains(lastQuery)) {
+                for (auto &&cell : _lastMatches) {
+                    if (_searchCellContains(cell, matcher))
+                        matches.push_back(cell);
+                }
+            } else {
+                for (size_t row = 0; row < _searchTexts.size(); ++row)
+                    _matchSearchRow(row, matcher, matches);
+            }
 
-            if (row < 0 ||
-                static_cast<size_t>(row) > l._rows.size())
-                return false;
+            const int stride = _searchColumns.size();
+            for (auto &&cell : matches)
+                result.append(index(cell / stride, _searchColumns[cell % stride]));
 
-            l.beginInsertRows(parent, row, row + count - 1);
+            _lastMatcher = matcher;
+            _lastMatches = std::move(matches);
 
-            auto rowIt = l._rows.begin() + row;
-            for (int i = 0; i < count; ++i)
-                l._rows.emplace(rowIt);
+            return result;
+        }
 
-            l.endInsertRows();
+    private:
+        // Bits of the mask stored for each row in _disabledRowFlags
+        enum _RowFlag
+        {
+            _RowNotSelectable = 0x1,
+            _RowReadOnly = 0x2,
+            _RowDisabled = 0x4
+        };
 
-            return true;
+        struct _ComputedColumn
+        {
+            const char *title;
+            std::function<QVariant(const _RowType &)> function;
+            std::bitset<rowSize> dependencies;
+        };
+
+        inline bool _indexIsInvalid(const QModelIndex &index) const
+        {
+            return
+                !index.isValid() ||
+                index.row() < 0 ||
+                index.row() >= rowCount() ||
+                index.column() < 0 ||
+                index .column() >= columnCount();
         }
-    };
 
-    template <typename... Types>
-    class ListInsertRows<false, Types...>
-    {
-    public:
-        static bool func(List<Types...> &l, int row, int count, const QModelIndex &parent)
+        QVariant _computedData(int row, int computedColumn, int role) const
         {
-            return static_cast<QAbstractTableModel &>(l).insertRows(row, count, parent);
+            if (role != Qt::DisplayRole && role != Qt::EditRole)
+                return {};
+
+            const auto cell = row * _computedColumns.size() + computedColumn;
+            if (!_computedIsCached[cell]) {
+                _computedValues[cell] = _computedColumns[computedColumn].function(_rows[row]);
+                _computedIsCached[cell] = true;
+            }
+
+            return _computedValues[cell];
         }
-    };
 
-    template <typename T>
-    class Table : public QAbstractTableModel
-    {
-    public:
-        Table(
-            const std::initializer_list<std::vector<T>> &l,
-            Util::RoleFunctions<T> &&roleFunctions,
-            QObject *parent = nullptr)
-        :
-            QAbstractTableModel{parent},
-            _roleFunctions{roleFunctions}
+        // Returns the range of computed columns that were invalidated, or
+        // (-1, -1) if none was
+        std::pair<int, int> _invalidateComputedValues(int row, int column)
         {
-            for(auto &&r : l) {
-                if (r.size() > _width)
-                    _width = r.size();
+            int first = -1, last = -1;
+            for (size_t i = 0; i < _computedColumns.size(); ++i) {
+                if (!_computedColumns[i].dependencies.test(column))
+                    continue;
 
-                _table.emplace_back();
-                auto &tableRow = *(_table.end() - 1);
-                int i = 0;
-                for (auto &&el : r)
-                    tableRow[i++] = el;
+                _computedIsCached[row * _computedColumns.size() + i] = false;
+                _computedValues[row * _computedColumns.size() + i] = QVariant{};
+
+                if (first < 0)
+                    first = i;
+                last = i;
             }
+
+            return std::make_pair(first, last);
         }
 
-        inline int rowCount(const QModelIndex &) const
+        void _resetComputedValues()
         {
-            return _table.size();
+            const auto cells = _rows.size() * _computedColumns.size();
+            _computedValues.assign(cells, QVariant{});
+            _computedIsCached.assign(cells, false);
         }
 
-        inline int columnCount(const QModelIndex &) const
+        template <typename RowIterator>
+        void _insertRows(int row, RowIterator first, RowIterator last)
         {
-            return _width;
+            int count = std::distance(first, last);
+
+            // When appending to a bounded list, rows that would be evicted
+            // right away are never inserted, and the oldest rows are evicted
+            // before the insertion so views never see more rows than the limit
+            if (_maximumRowCount > 0 && static_cast<size_t>(row) == _rows.size()) {
+                if (count > _maximumRowCount) {
+                    std::advance(first, count - _maximumRowCount);
+                    count = _maximumRowCount;
+                }
+
+                const int excess = static_cast<int>(_rows.size()) + count - _maximumRowCount;
+                if (excess > 0) {
+                    removeRows(0, excess);
+                    row -= excess;
+                }
+            }
+
+            if (count == 0)
+                return;
+
+            beginInsertRows({}, row, row + count - 1);
+
+            _rows.insert(_rows.begin() + row, first, last);
+            _insertRowData(row, count);
+
+            endInsertRows();
+
+            _evictExcessRows();
         }
 
-        QVariant data(const QModelIndex &index, int role) const
+        void _evictExcessRows()
         {
-            if (!indexIsValid(index))
-                return {};
+            if (_maximumRowCount > 0 && _rows.size() > static_cast<size_t>(_maximumRowCount))
+                removeRows(0, static_cast<int>(_rows.size()) - _maximumRowCount);
+        }
 
-            auto &row = _table[index.row()];
-            const auto columnInd = index.column();
+        // Keeps the per-row data stored alongside _rows in sync with it
+        void _insertRowData(int row, int count)
+        {
+            const auto stride = _computedColumns.size();
+            _computedValues.insert(_computedValues.begin() + row * stride, count * stride, QVariant{});
+            _computedIsCached.insert(_computedIsCached.begin() + row * stride, count * stride, false);
 
-            if (columnInd >= row.size())
-                return {};
+            _insertSearchTexts(row, count);
 
-            return _roleFunctions.data(role, row[index.column()]);
+            if (!_disabledRowFlags.empty())
+                _disabledRowFlags.insert(_disabledRowFlags.begin() + row, count, 0);
         }
 
-    private:
-        bool indexIsValid(const QModelIndex &index) const
+        void _moveRowData(int row, int count, int destination)
         {
-            return
-                index.isValid() ||
-                static_cast<size_t>(index.row()) < _table.size() ||
-                static_cast<size_t>(index.column()) < _width;
+            const int stride = _computedColumns.size();
+            _moveRange(_computedValues, row, count, destination, stride);
+            _moveRange(_computedIsCached, row, count, destination, stride);
+
+            _moveSearchTexts(row, count, destination);
+
+            if (!_disabledRowFlags.empty())
+                _moveRange(_disabledRowFlags, row, count, destination);
         }
 
-        std::vector<QHash<int, T>> _table;
+        void _permuteRowData(const std::vector<int> &newOrder)
+        {
+            const int stride = _computedColumns.size();
+            _permute(_computedValues, newOrder, stride);
+            _permute(_computedIsCached, newOrder, stride);
+
+            _permuteSearchTexts(newOrder);
+
+            if (!_disabledRowFlags.empty())
+                _permute(_disabledRowFlags, newOrder);
+        }
+
+        // Moves the count rows starting at row to before destination, where
+        // each row takes stride consecutive elements of c
+        template <typename Container>
+        static void _moveRange(Container &c, int row, int count, int destination, int stride = 1)
+        {
+            auto begin = c.begin();
+            if (destination < row)
+                std::rotate(
+                    begin + destination * stride,
+                    begin + row * stride,
+                    begin + (row + count) * stride);
+            else
+                std::rotate(
+                    begin + row * stride,
+                    begin + (row + count) * stride,
+                    begin + destination * stride);
+        }
+
+        // Follows each cycle of the permutation, so every element is moved
+        // exactly once
+        template <typename Container>
+        static void _permute(Container &c, const std::vector<int> &newOrder, int stride = 1)
+        {
+            std::vector<bool> placed(newOrder.size());
+            for (size_t start = 0; start < newOrder.size(); ++start) {
+                if (placed[start] || newOrder[start] == static_cast<int>(start))
+                    continue;
+
+                for (int k = 0; k < stride; ++k) {
+                    typename Container::value_type saved = std::move(c[start * stride + k]);
+
+                    size_t i = start;
+                    while (static_cast<size_t>(newOrder[i]) != start) {
+                        c[i * stride + k] = std::move(c[newOrder[i] * stride + k]);
+                        i = newOrder[i];
+                    }
+
+                    c[i * stride + k] = std::move(saved);
+                }
+
+                for (size_t i = start; !placed[i]; i = newOrder[i])
+                    placed[i] = true;
+            }
+        }
+
+        void _removeRowData(int row, int count)
+        {
+            const auto stride = _computedColumns.size();
+            _computedValues.erase(
+                _computedValues.begin() + row * stride,
+                _computedValues.begin() + (row + count) * stride);
+            _computedIsCached.erase(
+                _computedIsCached.begin() + row * stride,
+                _computedIsCached.begin() + (row + count) * stride);
+
+            _removeSearchTexts(row, count);
+
+            if (!_disabledRowFlags.empty())
+                _disabledRowFlags.erase(
+                    _disabledRowFlags.begin() + row,
+                    _disabledRowFlags.begin() + row + count);
+        }
+
+        void _updateColumnFlags()
+        {
+            const auto baseFlags = QAbstractTableModel::flags(createIndex(0, 0));
+
+            _columnFlags.assign(columnCount(), baseFlags);
+            for (int column = 0; column < rowSize; ++column) {
+                if (ListDataAccess<rowSize - 1, Types...>::columnIsEditable(*this, column))
+                    _columnFlags[column] |= Qt::ItemIsEditable;
+            }
+        }
+
+        inline bool _rowFlagIsDisabled(int row, _RowFlag flag) const
+        {
+            return !_disabledRowFlags.empty() && (_disabledRowFlags[row] & flag);
+        }
+
+        void _setRowFlagDisabled(int row, _RowFlag flag, bool disabled)
+        {
+            if (row < 0 || row >= rowCount() || _rowFlagIsDisabled(row, flag) == disabled)
+                return;
+
+            // Rows only take space once some row overrides its flags
+            if (_disabledRowFlags.empty())
+                _disabledRowFlags.assign(_rows.size(), 0);
+
+            if (disabled)
+                _disabledRowFlags[row] |= flag;
+            else
+                _disabledRowFlags[row] &= ~flag;
+
+            emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+        }
+
+        // Every row has the case folded text of its searched cells in
+        // _searchTexts, each followed by a null character, so an edit only
+        // rebuilds the text of its own row and rows are inserted, moved and
+        // removed like the rest of the per-row data
+        QString _searchText(int row) const
+        {
+            QString text;
+            for (auto &&column : _searchColumns) {
+                text.append(data(index(row, column)).toString().toCaseFolded());
+                text.append(QChar{});
+            }
+
+            return text;
+        }
+
+        // Appends the cells of row whose text contains the pattern of
+        // matcher to matches
+        void _matchSearchRow(int row, const QStringMatcher &matcher, std::vector<int> &matches) const
+        {
+            const int stride = _searchColumns.size();
+            const auto &text = _searchTexts[row];
+
+            int start = 0;
+            for (int i = 0; i < stride; ++i) {
+                const int end = text.indexOf(QChar{}, start);
+                if (matcher.indexIn(text.constData() + start, end - start) >= 0)
+                    matches.push_back(row * stride + i);
+
+                start = end + 1;
+            }
+        }
+
+        inline bool _searchCellContains(int cell, const QStringMatcher &matcher) const
+        {
+            const int stride = _searchColumns.size();
+            const auto &text = _searchTexts[cell / stride];
+
+            int start = 0;
+            for (int i = 0; i < cell % stride; ++i)
+                start = text.indexOf(QChar{}, start) + 1;
+
+            return matcher.indexIn(text.constData() + start, text.indexOf(QChar{}, start) - start) >= 0;
+        }
+
+        // Keeps the matches of the last query valid after removed rows
+        // starting at row were replaced by inserted ones, scanning only the
+        // inserted rows
+        void _updateLastMatches(int row, int removed, int inserted)
+        {
+            if (_lastMatcher.pattern().isEmpty())
+                return;
+
+            const int stride = _searchColumns.size();
+            auto first = std::lower_bound(_lastMatches.begin(), _lastMatches.end(), row * stride);
+            auto last = std::lower_bound(first, _lastMatches.end(), (row + removed) * stride);
+            if (inserted != removed) {
+                for (auto it = last; it != _lastMatches.end(); ++it)
+                    *it += (inserted - removed) * stride;
+            }
+
+            std::vector<int> found;
+            for (int i = row; i < row + inserted; ++i)
+                _matchSearchRow(i, _lastMatcher, found);
+
+            const auto position = _lastMatches.erase(first, last) - _lastMatches.begin();
+            _lastMatches.insert(_lastMatches.begin() + position, found.begin(), found.end());
+        }
+
+        void _insertSearchTexts(int row, int count)
+        {
+            if (_searchColumns.empty())
+                return;
+
+            std::vector<QString> texts;
+            texts.reserve(count);
+            for (int i = row; i < row + count; ++i)
+                texts.push_back(_searchText(i));
+
+            _searchTexts.insert(
+                _searchTexts.begin() + row,
+                std::make_move_iterator(texts.begin()),
+                std::make_move_iterator(texts.end()));
+
+            _updateLastMatches(row, 0, count);
+        }
+
+        void _removeSearchTexts(int row, int count)
+        {
+            if (_searchColumns.empty())
+                return;
+
+            _searchTexts.erase(_searchTexts.begin() + row, _searchTexts.begin() + row + count);
+
+            _updateLastMatches(row, count, 0);
+        }
+
+        void _updateSearchTexts(int row)
+        {
+            if (_searchColumns.empty())
+                return;
+
+            _searchTexts[row] = _searchText(row);
+
+            _updateLastMatches(row, 1, 1);
+        }
+
+        void _moveSearchTexts(int row, int count, int destination)
+        {
+            if (_searchColumns.empty())
+                return;
+
+            _moveRange(_searchTexts, row, count, destination);
+
+            if (_lastMatcher.pattern().isEmpty())
+                return;
+
+            const int stride = _searchColumns.size();
+            for (auto &&cell : _lastMatches) {
+                const int matchRow = cell / stride;
+                int newRow = matchRow;
+                if (matchRow >= row && matchRow < row + count)
+                    newRow = destination < row? destination + matchRow - row : destination - count + matchRow - row;
+                else if (destination < row && matchRow >= destination && matchRow < row)
+                    newRow = matchRow + count;
+                else if (destination > row && matchRow >= row + count && matchRow < destination)
+                    newRow = matchRow - count;
+
+                cell = newRow * stride + cell % stride;
+            }
+            std::sort(_lastMatches.begin(), _lastMatches.end());
+        }
+
+        void _permuteSearchTexts(const std::vector<int> &newOrder)
+        {
+            if (_searchColumns.empty())
+                return;
+
+            _permute(_searchTexts, newOrder);
+
+            if (_lastMatcher.pattern().isEmpty())
+                return;
+
+            std::vector<int> newRows(newOrder.size());
+            for (size_t i = 0; i < newOrder.size(); ++i)
+                newRows[newOrder[i]] = i;
+
+            const int stride = _searchColumns.size();
+            for (auto &&cell : _lastMatches)
+                cell = newRows[cell / stride] * stride + cell % stride;
+            std::sort(_lastMatches.begin(), _lastMatches.end());
+        }
+
+        void _resetSearchTexts()
+        {
+            _searchTexts.clear();
+            if (!_searchColumns.empty()) {
+                for (size_t row = 0; row < _rows.size(); ++row)
+                    _searchTexts.push_back(_searchText(row));
+            }
+
+            _lastMatcher.setPattern({});
+            _lastMatches.clear();
+        }
+
+        std::array<const char *, rowSize> _headerTitles;
+        std::deque<_RowType> _rows;
+        std::tuple<Util::RoleFunctions<Types>...> _roleFunctions;
+
+        std::vector<_ComputedColumn> _computedColumns;
+        mutable std::deque<QVariant> _computedValues;
+        mutable std::deque<bool> _computedIsCached;
+
+        int _maximumRowCount = 0;
+        std::vector<_RowType> _pendingRows;
+
+        std::vector<int> _searchColumns;
+        std::deque<QString> _searchTexts;
+        mutable QStringMatcher _lastMatcher;
+        mutable std::vector<int> _lastMatches;
+
+        std::vector<Qt::ItemFlags> _columnFlags;
+
+        // One _RowFlag mask per row, empty until a row overrides its flags
+        std::deque<quint8> _disabledRowFlags;
+
+        List(
+            const decltype(_headerTitles) &headerTitles,
+            std::initializer_list<_RowType> &&l,
+            const decltype(_roleFunctions) &roleFunctions,
+            const decltype(_computedColumns) &computedColumns,
+            int maximumRowCount,
+            QObject *parent)
+        :
+            QAbstractTableModel{parent},
+            _headerTitles(std::move(headerTitles)),
+            _rows{l},
+            _roleFunctions{roleFunctions},
+            _computedColumns(computedColumns),
+            _maximumRowCount{maximumRowCount}
+        {
+            _resetComputedValues();
+            _updateColumnFlags();
+            _evictExcessRows();
+        }
+
+        template <int I, typename... ListTypes>
+        friend class ListDataAccess;
+
+        template <bool B, typename... ListTypes>
+        friend class ListInsertRows;
+    };
+
+    template <int I, typename... Types>
+    class ListDataAccess
+    {
+    public:
+        static QVariant getFromIndex(const List<Types...> &list, const QModelIndex &i, int role)
+        {
+            if (i.column() != I)
+                return ListDataAccess<I - 1, Types...>::getFromIndex(list, i, role);
+
+            return std::get<I>(list._roleFunctions).data(
+                role,
+                std::get<I>(list._rows[i.row()]));
+        }
+
+        static bool columnIsEditable(const List<Types...> &list, const int &column)
+        {
+            if (column != I)
+                return ListDataAccess<I - 1, Types...>::columnIsEditable(list, column);
+
+            return std::get<I>(list._roleFunctions).isEditable();
+        }
+
+        static bool setInIndex(List<Types...> &list, const QModelIndex &i, const QVariant &data, const int &role)
+        {
+            if (i.column() != I)
+                return ListDataAccess<I - 1, Types...>::setInIndex(list, i, data, role);
+
+            return std::get<I>(list._roleFunctions).setData(
+                role,
+                std::get<I>(list._rows[i.row()]),
+                data);
+        }
+    };
+
+    template <typename... Types>
+    class ListDataAccess<-1, Types...>
+    {
+    public:
+        static QVariant getFromIndex(const List<Types...> &, const QModelIndex &, int)
+        {
+            return {};
+        }
+
+        static bool columnIsEditable(const List<Types...> &, const int &)
+        {
+            return false;
+        }
+
+        static bool setInIndex(List<Types...> &, const QModelIndex &, const QVariant &, const int &)
+        {
+            return false;
+        }
+    };
+
+    template <bool DefaultConstructible, typename... Types>
+    class ListInsertRows;
+
+    template <typename... Types>
+    class ListInsertRows<true, Types...>
+    {
+    public:
+        static bool func(List<Types...> &l, int row, int count, const QModelIndex &parent)
+        {
+            if (count == 0)
+                return true;
+
+            if (row < 0 ||
+                static_cast<size_t>(row) > l._rows.size())
+                return false;
+
+            l.beginInsertRows(parent, row, row + count - 1);
+
+            for (int i = 0; i < count; ++i)
+                l._rows.emplace(l._rows.begin() + row);
+
+            l._insertRowData(row, count);
+
+            l.endInsertRows();
+
+            l._evictExcessRows();
+
+            return true;
+        }
+    };
+
+    template <typename... Types>
+    class ListInsertRows<false, Types...>
+    {
+    public:
+        static bool func(List<Types...> &l, int row, int count, const QModelIndex &parent)
+        {
+            return static_cast<QAbstractTableModel &>(l).insertRows(row, count, parent);
+        }
+    };
+
+    // Groups the rows of a List by one of its columns
+    //
+    // The first column shows the group key and the second one the number of
+    // rows in the group; aggregates over other columns can be added after
+    // it. Groups and aggregates are updated incrementally as the source
+    // changes, so the key and aggregated types must be less-than comparable.
+    template <std::size_t KeyColumn, typename... Types>
+    class GroupedView : public QAbstractTableModel
+    {
+        typedef std::tuple<Types...> _RowType;
+        typedef typename std::tuple_element<KeyColumn, _RowType>::type _KeyType;
+
+        struct _Aggregate
+        {
+            std::function<void(const _KeyType &, const _RowType &)> add;
+            std::function<void(const _KeyType &, const _RowType &)> remove;
+            std::function<void(const _KeyType &)> drop;
+            std::function<QVariant(const _KeyType &)> value;
+
+            // Whether the aggregated column differs between two rows
+            std::function<bool(const _RowType &, const _RowType &)> differs;
+        };
+
+    public:
+        GroupedView(
+            List<Types...> &source,
+            const char *keyTitle,
+            Util::RoleFunctions<_KeyType> &&keyRoles,
+            QObject *parent = nullptr)
+        :
+            QAbstractTableModel{parent},
+            _source(source),
+            _headerTitles{keyTitle, "Count"},
+            _keyRoles{keyRoles}
+        {
+            _addRows(0, _source.rowCount() - 1);
+
+            connect(
+                &_source, &QAbstractItemModel::rowsInserted, this,
+                [this](const QModelIndex &, int first, int last) { _addRows(first, last); });
+            connect(
+                &_source, &QAbstractItemModel::rowsAboutToBeRemoved, this,
+                [this](const QModelIndex &, int first, int last) { _removeRows(first, last); });
+            connect(
+                &_source, &QAbstractItemModel::dataChanged, this,
+                [this](const QModelIndex &topLeft, const QModelIndex &bottomRight)
+                {
+                    // Computed columns aren't part of the rows being grouped
+                    if (topLeft.column() >= List<Types...>::rowSize)
+                        return;
+
+                    _updateRows(topLeft.row(), bottomRight.row());
+                });
+            connect(
+                &_source, &QAbstractItemModel::rowsMoved, this,
+                [this](const QModelIndex &, int first, int last, const QModelIndex &, int destination)
+                {
+                    _moveRows(first, last, destination);
+                });
+            connect(&_source, &QAbstractItemModel::modelReset, this, [this]() { _reset(); });
+            connect(&_source, &QAbstractItemModel::layoutChanged, this, [this]() { _copyRows(); });
+        }
+
+        GroupedView(
+            List<Types...> &source,
+            const char *keyTitle = "",
+            QObject *parent = nullptr)
+        :
+            GroupedView{source, keyTitle, Util::RoleFunctions<_KeyType>(), parent}
+        {}
+
+        int rowCount(const QModelIndex & = {}) const
+        {
+            return _groups.size();
+        }
+
+        int columnCount(const QModelIndex & = {}) const
+        {
+            return _headerTitles.size();
+        }
+
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const
+        {
+            if (
+                !index.isValid() ||
+                index.row() < 0 ||
+                index.row() >= rowCount() ||
+                index.column() < 0 ||
+                index.column() >= columnCount())
+                return {};
+
+            const auto &key = _groups[index.row()];
+
+            if (index.column() == 0)
+                return _keyRoles.data(role, key);
+
+            if (role != Qt::DisplayRole && role != Qt::EditRole)
+                return {};
+
+            if (index.column() == 1)
+                return _counts.at(key);
+
+            return _aggregates[index.column() - 2].value(key);
+        }
+
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const
+        {
+            if (
+                section < 0 ||
+                section >= columnCount() ||
+                orientation != Qt::Horizontal ||
+                role != Qt::DisplayRole)
+                return QAbstractTableModel::headerData(section, orientation, role);
+
+            return _headerTitles[section];
+        }
+
+        // Adds a column folding the values of Column into an accumulator;
+        // remove must undo what add did for the same value
+        template <std::size_t Column, typename Accumulator>
+        void addAggregate(
+            const char *title,
+            const Accumulator &initial,
+            std::function<
+                void(
+                    Accumulator &,
+                    const typename std::tuple_element<
+                        Column, _RowType
+                    >::type &)> &&add,
+            std::function<
+                void(
+                    Accumulator &,
+                    const typename std::tuple_element<
+                        Column, _RowType
+                    >::type &)> &&remove)
+        {
+            auto accumulators = std::make_shared<std::map<_KeyType, Accumulator>>();
+
+            _addAggregate<Column>(
+                title,
+                {
+                    [accumulators, initial, add](const _KeyType &key, const _RowType &row)
+                    {
+                        auto it = accumulators->find(key);
+                        if (it == accumulators->end())
+                            it = accumulators->insert(std::make_pair(key, initial)).first;
+
+                        add(it->second, std::get<Column>(row));
+                    },
+                    [accumulators, remove](const _KeyType &key, const _RowType &row)
+                    {
+                        remove(accumulators->at(key), std::get<Column>(row));
+                    },
+                    [accumulators](const _KeyType &key) { accumulators->erase(key); },
+                    [accumulators](const _KeyType &key)
+                    {
+                        return QVariant::fromValue(accumulators->at(key));
+                    },
+                    {}
+                });
+        }
+
+        template <std::size_t Column>
+        void addSum(const char *title)
+        {
+            typedef typename std::tuple_element<Column, _RowType>::type ValueType;
+
+            addAggregate<Column, ValueType>(
+                title,
+                ValueType{},
+                [](ValueType &sum, const ValueType &value) { sum += value; },
+                [](ValueType &sum, const ValueType &value) { sum -= value; });
+        }
+
+        template <std::size_t Column>
+        void addMinimum(const char *title)
+        {
+            _addExtremum<Column>(title, false);
+        }
+
+        template <std::size_t Column>
+        void addMaximum(const char *title)
+        {
+            _addExtremum<Column>(title, true);
+        }
+
+        void setHeaderTitle(int section, const char *title)
+        {
+            _headerTitles[section] = title;
+        }
+
+    private:
+        template <std::size_t Column>
+        void _addAggregate(const char *title, _Aggregate &&aggregate)
+        {
+            aggregate.differs = [](const _RowType &a, const _RowType &b)
+            {
+                return
+                    std::get<Column>(a) < std::get<Column>(b) ||
+                    std::get<Column>(b) < std::get<Column>(a);
+            };
+
+            const int column = columnCount();
+            beginInsertColumns({}, column, column);
+
+            for (auto &&row : _rows)
+                aggregate.add(std::get<KeyColumn>(row), row);
+
+            _headerTitles.push_back(title);
+            _aggregates.push_back(std::move(aggregate));
+
+            endInsertColumns();
+        }
+
+        // Minima and maxima can't be undone by a reducer, so every value of
+        // the group is kept sorted instead
+        template <std::size_t Column>
+        void _addExtremum(const char *title, bool maximum)
+        {
+            typedef typename std::tuple_element<Column, _RowType>::type ValueType;
+
+            auto values = std::make_shared<std::map<_KeyType, std::multiset<ValueType>>>();
+
+            _addAggregate<Column>(
+                title,
+                {
+                    [values](const _KeyType &key, const _RowType &row)
+                    {
+                        (*values)[key].insert(std::get<Column>(row));
+                    },
+                    [values](const _KeyType &key, const _RowType &row)
+                    {
+                        auto &groupValues = values->at(key);
+                        groupValues.erase(groupValues.find(std::get<Column>(row)));
+                    },
+                    [values](const _KeyType &key) { values->erase(key); },
+                    [values, maximum](const _KeyType &key)
+                    {
+                        const auto &groupValues = values->at(key);
+                        if (groupValues.empty())
+                            return QVariant{};
+
+                        return QVariant::fromValue(
+                            maximum? *groupValues.rbegin() : *groupValues.begin());
+                    },
+                    {}
+                });
+        }
+
+        int _groupRow(const _KeyType &key) const
+        {
+            return std::lower_bound(_groups.begin(), _groups.end(), key) - _groups.begin();
+        }
+
+        void _groupChanged(int groupRow)
+        {
+            emit dataChanged(index(groupRow, 1), index(groupRow, columnCount() - 1));
+        }
+
+        void _addRow(const _RowType &row)
+        {
+            const auto &key = std::get<KeyColumn>(row);
+            const int groupRow = _groupRow(key);
+
+            auto count = _counts.find(key);
+            if (count != _counts.end()) {
+                ++count->second;
+                for (auto &&aggregate : _aggregates)
+                    aggregate.add(key, row);
+
+                _groupChanged(groupRow);
+                return;
+            }
+
+            beginInsertRows({}, groupRow, groupRow);
+
+            _groups.insert(_groups.begin() + groupRow, key);
+            _counts.insert(std::make_pair(key, 1));
+            for (auto &&aggregate : _aggregates)
+                aggregate.add(key, row);
+
+            endInsertRows();
+        }
+
+        void _removeRow(const _RowType &row)
+        {
+            const auto &key = std::get<KeyColumn>(row);
+            const int groupRow = _groupRow(key);
+
+            auto count = _counts.find(key);
+            Q_ASSERT(count != _counts.end());
+
+            if (count->second > 1) {
+                --count->second;
+                for (auto &&aggregate : _aggregates)
+                    aggregate.remove(key, row);
+
+                _groupChanged(groupRow);
+                return;
+            }
+
+            beginRemoveRows({}, groupRow, groupRow);
+
+            for (auto &&aggregate : _aggregates)
+                aggregate.drop(key);
+            _counts.erase(count);
+            _groups.erase(_groups.begin() + groupRow);
+
+            endRemoveRows();
+        }
+
+        void _addRows(int first, int last)
+        {
+            for (int i = first; i <= last; ++i) {
+                _rows.insert(_rows.begin() + i, _source.row(i));
+                _addRow(_rows[i]);
+            }
+        }
+
+        void _removeRows(int first, int last)
+        {
+            for (int i = first; i <= last; ++i)
+                _removeRow(_rows[i]);
+
+            _rows.erase(_rows.begin() + first, _rows.begin() + last + 1);
+        }
+
+        void _updateRows(int first, int last)
+        {
+            for (int i = first; i <= last; ++i) {
+                const auto &newRow = _source.row(i);
+                auto &oldRow = _rows[i];
+
+                if (!(std::get<KeyColumn>(oldRow) < std::get<KeyColumn>(newRow)) &&
+                    !(std::get<KeyColumn>(newRow) < std::get<KeyColumn>(oldRow))) {
+                    const auto &key = std::get<KeyColumn>(oldRow);
+
+                    bool changed = false;
+                    for (auto &&aggregate : _aggregates) {
+                        if (!aggregate.differs(oldRow, newRow))
+                            continue;
+
+                        aggregate.remove(key, oldRow);
+                        aggregate.add(key, newRow);
+                        changed = true;
+                    }
+
+                    oldRow = newRow;
+                    if (changed)
+                        _groupChanged(_groupRow(key));
+
+                    continue;
+                }
+
+                _removeRow(oldRow);
+                oldRow = newRow;
+                _addRow(oldRow);
+            }
+        }
+
+        // Reordering the source doesn't change any group, only the copy of
+        // its rows needs to follow
+        void _moveRows(int first, int last, int destination)
+        {
+            auto begin = _rows.begin();
+            if (destination < first)
+                std::rotate(begin + destination, begin + first, begin + last + 1);
+            else
+                std::rotate(begin + first, begin + last + 1, begin + destination);
+        }
+
+        void _copyRows()
+        {
+            for (int i = 0; i < _source.rowCount(); ++i)
+                _rows[i] = _source.row(i);
+        }
+
+        void _reset()
+        {
+            beginResetModel();
+
+            for (auto &&key : _groups) {
+                for (auto &&aggregate : _aggregates)
+                    aggregate.drop(key);
+            }
+            _groups.clear();
+            _counts.clear();
+            _rows.clear();
+
+            for (int i = 0; i < _source.rowCount(); ++i) {
+                _rows.push_back(_source.row(i));
+
+                const auto &row = _rows.back();
+                const auto &key = std::get<KeyColumn>(row);
+
+                auto count = _counts.find(key);
+                if (count == _counts.end()) {
+                    _groups.insert(_groups.begin() + _groupRow(key), key);
+                    _counts.insert(std::make_pair(key, 1));
+                } else {
+                    ++count->second;
+                }
+
+                for (auto &&aggregate : _aggregates)
+                    aggregate.add(key, row);
+            }
+
+            endResetModel();
+        }
+
+        List<Types...> &_source;
+        std::vector<const char *> _headerTitles;
+        Util::RoleFunctions<_KeyType> _keyRoles;
+
+        // Copy of the source rows, needed to know what an edited row held
+        // before dataChanged was emitted
+        std::deque<_RowType> _rows;
+        std::vector<_KeyType> _groups;
+        std::map<_KeyType, int> _counts;
+        std::vector<_Aggregate> _aggregates;
+    };
+
+    template <typename T>
+    class Table : public QAbstractTableModel
+    {
+    public:
+        Table(
+            const std::initializer_list<std::vector<T>> &l,
+            Util::RoleFunctions<T> &&roleFunctions,
+            QObject *parent = nullptr)
+        :
+            QAbstractTableModel{parent},
+            _roleFunctions{roleFunctions}
+        {
+            for(auto &&r : l) {
+                if (r.size() > _width)
+                    _width = r.size();
+
+                _table.emplace_back();
+                auto &tableRow = *(_table.end() - 1);
+                int i = 0;
+                for (auto &&el : r)
+                    tableRow[i++] = el;
+            }
+        }
+
+        inline int rowCount(const QModelIndex &) const
+        {
+            return _table.size();
+        }
+
+        inline int columnCount(const QModelIndex &) const
+        {
+            return _width;
+        }
+
+        QVariant data(const QModelIndex &index, int role) const
+        {
+            if (!indexIsValid(index))
+                return {};
+
+            auto &row = _table[index.row()];
+            const auto columnInd = index.column();
+
+            if (columnInd >= row.size())
+                return {};
+
+            return _roleFunctions.data(role, row[index.column()]);
+        }
+
+    private:
+        bool indexIsValid(const QModelIndex &index) const
+        {
+            return
+                index.isValid() ||
+                static_cast<size_t>(index.row()) < _table.size() ||
+                static_cast<size_t>(index.column()) < _width;
+        }
+
+        std::vector<QHash<int, T>> _table;
         size_t _width = 0;
         Util::RoleFunctions<T> _roleFunctions;
     };
 
+
+    // A tree whose nodes have a fixed number of columns
+    //
+    // Nodes are kept in a flat arena indexed by node id. Each node knows its
+    // parent and its position among its siblings, and each parent keeps the
+    // ids of its children, so both index() and parent() are O(1).
+    template <typename... Types>
+    class Tree : public QAbstractItemModel
+    {
+        static_assert(
+            sizeof...(Types) > 0,
+            "Cannot instantiate QtMVT::Model::Tree with no template arguments");
+
+        typedef std::tuple<Types...> _RowType;
+
+    public:
+        static const constexpr int rowSize = std::tuple_size<_RowType>::value;
+
+        // A subtree to be inserted into the model
+        struct Node
+        {
+            std::tuple<Types...> row;
+            std::vector<Node> children;
+        };
+
+        typedef std::function<std::vector<Node>(const std::tuple<Types...> &)> FetchFunction;
+
+        Tree(
+            std::array<const char *, rowSize> &&headerTitles,
+            std::initializer_list<Node> &&nodes,
+            Util::RoleFunctions<Types> &&... roles,
+            QObject *parent = nullptr)
+        :
+            QAbstractItemModel{parent},
+            _headerTitles(std::move(headerTitles)),
+            _roleFunctions{roles...}
+        {
+            for (auto &&node : nodes)
+                _topLevelNodes.push_back(_createNode(node, -1, _topLevelNodes.size()));
+        }
+
+        Tree(
+            std::array<const char *, rowSize> &&headerTitles,
+            std::initializer_list<Node> &&nodes,
+            std::function<QVariant(const Types &)> &&... displayFunctions,
+            std::function<bool(Types &, const QVariant &)> &&... editFunctions,
+            QObject *parent = nullptr)
+        :
+            Tree{
+                std::move(headerTitles),
+                std::move(nodes),
+                {
+                    {{Qt::DisplayRole, displayFunctions}},
+                    {{Qt::EditRole, editFunctions}}
+                }...,
+                parent}
+        {}
+
+        Tree(
+            std::array<const char *, rowSize> &&headerTitles,
+            std::initializer_list<Node> &&nodes,
+            std::function<QVariant(const Types &)> &&... displayFunctions,
+            QObject *parent = nullptr)
+        :
+            Tree{
+                std::move(headerTitles),
+                std::move(nodes),
+                {
+                    {{Qt::DisplayRole, displayFunctions}},
+                    {}
+                }...,
+                parent}
+        {}
+
+        Tree(
+            std::array<const char *, rowSize> &&headerTitles,
+            std::initializer_list<Node> &&nodes = {},
+            QObject *parent = nullptr)
+        :
+            Tree{
+                std::move(headerTitles),
+                std::move(nodes),
+                Util::RoleFunctions<Types>()...,
+                parent}
+        {}
+
+        Tree(QObject *parent = nullptr) :
+            Tree{{}, {}, parent}
+        {}
+
+        QModelIndex index(int row, int column, const QModelIndex &parent = {}) const
+        {
+            if (column < 0 || column >= rowSize || parent.column() > 0)
+                return {};
+
+            const auto &children = _childrenOf(_nodeOf(parent));
+            if (row < 0 || static_cast<size_t>(row) >= children.size())
+                return {};
+
+            return createIndex(row, column, static_cast<quintptr>(children[row]));
+        }
+
+        QModelIndex parent(const QModelIndex &child) const
+        {
+            if (!child.isValid())
+                return {};
+
+            const auto parentNode = _parents[_nodeOf(child)];
+            if (parentNode < 0)
+                return {};
+
+            return createIndex(_rowsInParent[parentNode], 0, static_cast<quintptr>(parentNode));
+        }
+
+        int rowCount(const QModelIndex &parent = {}) const
+        {
+            if (parent.column() > 0)
+                return 0;
+
+            return _childrenOf(_nodeOf(parent)).size();
+        }
+
+        int columnCount(const QModelIndex & = {}) const
+        {
+            return rowSize;
+        }
+
+        bool hasChildren(const QModelIndex &parent = {}) const
+        {
+            return rowCount(parent) > 0 || canFetchMore(parent);
+        }
+
+        bool canFetchMore(const QModelIndex &parent) const
+        {
+            return
+                _fetchFunction &&
+                parent.isValid() &&
+                parent.column() == 0 &&
+                !_fetched[_nodeOf(parent)];
+        }
+
+        void fetchMore(const QModelIndex &parent)
+        {
+            if (!canFetchMore(parent))
+                return;
+
+            const auto node = _nodeOf(parent);
+            _fetched[node] = true;
+
+            auto nodes = _fetchFunction(_rows[node]);
+            _insertNodes(node, _children[node].size(), nodes.begin(), nodes.end());
+        }
+
+        QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const
+        {
+            if (_indexIsInvalid(index))
+                return {};
+
+            return TreeDataAccess<rowSize - 1, Types...>::getFromIndex(*this, index, role);
+        }
+
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const
+        {
+            if (
+                section < 0 ||
+                section >= rowSize ||
+                orientation != Qt::Horizontal ||
+                role != Qt::DisplayRole)
+                return QAbstractItemModel::headerData(section, orientation, role);
+
+            return _headerTitles[section];
+        }
+
+        Qt::ItemFlags flags(const QModelIndex &index) const
+        {
+            return
+                QAbstractItemModel::flags(index) |
+                (TreeDataAccess<rowSize - 1, Types...>::columnIsEditable(*this, index.column())?
+                     Qt::ItemIsEditable :
+                     Qt::NoItemFlags);
+        }
+
+        bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole)
+        {
+            if (_indexIsInvalid(index))
+                return false;
+
+            if (!TreeDataAccess<rowSize - 1, Types...>::setInIndex(*this, index, value, role))
+                return false;
+
+            emit dataChanged(index, index);
+
+            return true;
+        }
+
+        bool removeRows(int row, int count, const QModelIndex &parent = {})
+        {
+            if (count == 0)
+                return true;
+
+            if (parent.column() > 0)
+                return false;
+
+            auto &children = _childrenOf(_nodeOf(parent));
+            if (row < 0 ||
+                count < 0 ||
+                static_cast<size_t>(row + count) > children.size())
+                return false;
+
+            beginRemoveRows(parent, row, row + count - 1);
+
+            auto first = children.begin() + row;
+            auto last = first + count;
+            for (auto it = first; it != last; ++it)
+                _destroyNode(*it);
+
+            children.erase(first, last);
+            _renumberChildren(children, row);
+
+            endRemoveRows();
+
+            return true;
+        }
+
+        const std::tuple<Types...> &row(const QModelIndex &index) const
+        {
+            Q_ASSERT(index.isValid());
+            return _rows[_nodeOf(index)];
+        }
+
+        // Inserts whole subtrees under parent, emitting a single rowsInserted
+        bool insert(int row, const QModelIndex &parent, std::initializer_list<Node> &&nodes)
+        {
+            if (nodes.size() == 0)
+                return true;
+
+            if (parent.column() > 0)
+                return false;
+
+            const auto parentNode = _nodeOf(parent);
+            if (row < 0 || static_cast<size_t>(row) > _childrenOf(parentNode).size())
+                return false;
+
+            _insertNodes(parentNode, row, nodes.begin(), nodes.end());
+
+            return true;
+        }
+
+        bool insert(int row, const QModelIndex &parent, Node &&node)
+        {
+            return insert(row, parent, {std::move(node)});
+        }
+
+        bool append(const QModelIndex &parent, std::initializer_list<Node> &&nodes)
+        {
+            return insert(rowCount(parent), parent, std::move(nodes));
+        }
+
+        bool append(const QModelIndex &parent, Node &&node)
+        {
+            return append(parent, {std::move(node)});
+        }
+
+        // Children of a node are requested from function the first time a
+        // view expands it; nodes inserted along with their children are
+        // considered to be already fetched
+        void setFetchFunction(FetchFunction &&function)
+        {
+            beginResetModel();
+
+            _fetchFunction = function;
+
+            endResetModel();
+        }
+
+        void setHeaderTitle(int section, const char *title)
+        {
+            _headerTitles[section] = title;
+        }
+
+    private:
+        inline int _nodeOf(const QModelIndex &index) const
+        {
+            return index.isValid()? static_cast<int>(index.internalId()) : -1;
+        }
+
+        inline bool _indexIsInvalid(const QModelIndex &index) const
+        {
+            return
+                !index.isValid() ||
+                index.model() != this ||
+                index.column() < 0 ||
+                index.column() >= rowSize;
+        }
+
+        inline const std::vector<int> &_childrenOf(int node) const
+        {
+            return node < 0? _topLevelNodes : _children[node];
+        }
+
+        inline std::vector<int> &_childrenOf(int node)
+        {
+            return node < 0? _topLevelNodes : _children[node];
+        }
+
+        void _renumberChildren(const std::vector<int> &children, int from)
+        {
+            for (size_t i = from; i < children.size(); ++i)
+                _rowsInParent[children[i]] = i;
+        }
+
+        int _createNode(const Node &node, int parentNode, int rowInParent)
+        {
+            int id;
+            if (_freeNodes.empty()) {
+                id = _rows.size();
+                _rows.push_back(node.row);
+                _parents.push_back(parentNode);
+                _rowsInParent.push_back(rowInParent);
+                _children.emplace_back();
+                _fetched.push_back(false);
+            } else {
+                id = _freeNodes.back();
+                _freeNodes.pop_back();
+                _rows[id] = node.row;
+                _parents[id] = parentNode;
+                _rowsInParent[id] = rowInParent;
+                _fetched[id] = false;
+            }
+
+            if (!node.children.empty()) {
+                _fetched[id] = true;
+
+                std::vector<int> children;
+                children.reserve(node.children.size());
+                for (auto &&child : node.children)
+                    children.push_back(_createNode(child, id, children.size()));
+
+                _children[id] = std::move(children);
+            }
+
+            return id;
+        }
+
+        void _destroyNode(int node)
+        {
+            for (auto &&child : _children[node])
+                _destroyNode(child);
+
+            _children[node].clear();
+            _freeNodes.push_back(node);
+        }
+
+        template <typename NodeIterator>
+        void _insertNodes(int parentNode, int row, NodeIterator first, NodeIterator last)
+        {
+            const int count = std::distance(first, last);
+            if (count == 0)
+                return;
+
+            const auto parent =
+                parentNode < 0?
+                    QModelIndex{} :
+                    createIndex(_rowsInParent[parentNode], 0, static_cast<quintptr>(parentNode));
+
+            beginInsertRows(parent, row, row + count - 1);
+
+            std::vector<int> ids;
+            ids.reserve(count);
+            for (auto it = first; it != last; ++it)
+                ids.push_back(_createNode(*it, parentNode, row + ids.size()));
+
+            auto &children = _childrenOf(parentNode);
+            children.insert(children.begin() + row, ids.begin(), ids.end());
+            _renumberChildren(children, row + count);
+
+            endInsertRows();
+        }
+
+        std::array<const char *, rowSize> _headerTitles;
+        std::tuple<Util::RoleFunctions<Types>...> _roleFunctions;
+
+        std::vector<_RowType> _rows;
+        std::vector<int> _parents;
+        std::vector<int> _rowsInParent;
+        std::vector<std::vector<int>> _children;
+        std::vector<bool> _fetched;
+        std::vector<int> _freeNodes;
+        std::vector<int> _topLevelNodes;
+
+        FetchFunction _fetchFunction;
+
+        template <int I, typename... TreeTypes>
+        friend class TreeDataAccess;
+    };
+
+    template <int I, typename... Types>
+    class TreeDataAccess
+    {
+    public:
+        static QVariant getFromIndex(const Tree<Types...> &tree, const QModelIndex &i, int role)
+        {
+            if (i.column() != I)
+                return TreeDataAccess<I - 1, Types...>::getFromIndex(tree, i, role);
+
+            return std::get<I>(tree._roleFunctions).data(
+                role,
+                std::get<I>(tree._rows[tree._nodeOf(i)]));
+        }
+
+        static bool columnIsEditable(const Tree<Types...> &tree, const int &column)
+        {
+            if (column != I)
+                return TreeDataAccess<I - 1, Types...>::columnIsEditable(tree, column);
+
+            return std::get<I>(tree._roleFunctions).isEditable();
+        }
+
+        static bool setInIndex(Tree<Types...> &tree, const QModelIndex &i, const QVariant &data, const int &role)
+        {
+            if (i.column() != I)
+                return TreeDataAccess<I - 1, Types...>::setInIndex(tree, i, data, role);
+
+            return std::get<I>(tree._roleFunctions).setData(
+                role,
+                std::get<I>(tree._rows[tree._nodeOf(i)]),
+                data);
+        }
+    };
+
+    template <typename... Types>
+    class TreeDataAccess<-1, Types...>
+    {
+    public:
+        static QVariant getFromIndex(const Tree<Types...> &, const QModelIndex &, int)
+        {
+            return {};
+        }
+
+        static bool columnIsEditable(const Tree<Types...> &, const int &)
+        {
+            return false;
+        }
+
+        static bool setInIndex(Tree<Types...> &, const QModelIndex &, const QVariant &, const int &)
+        {
+            return false;
+        }
+    };
+
     }
 
 }